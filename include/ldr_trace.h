@@ -0,0 +1,91 @@
+// ============================================================================
+// FORMATO DE TRACE DO SENSOR LDR
+// ============================================================================
+// Formato binário compacto usado para gravar as leituras brutas de
+// analogRead(LDR_PIN) no firmware (modo TRACE_CAPTURE) e reproduzi-las no
+// driver de replay nativo (src/replay_native.cpp).
+//
+// Cabeçalho (12 bytes):
+//   [0..3]  magic "LDRT"
+//   [4]     versão do formato
+//   [5..7]  reservado (0)
+//   [8..11] base_ms: uint32 little-endian com millis() ao gravar o cabeçalho
+//
+// Registros (4 bytes cada, little-endian):
+//   dt_ms: uint16 - milissegundos desde o registro anterior (ou base_ms)
+//   value: uint16 - leitura ADC (0-1023)
+//
+// Intervalos maiores que TRACE_MAX_DT_MS geram registros de salto com
+// value = TRACE_SKIP_VALUE (apenas avançam o tempo, sem amostra).
+//
+// O cabeçalho é repetido a cada TRACE_SYNC_RECORDS registros como ponto de
+// sincronismo: se a UART perder bytes, o leitor realinha no próximo
+// cabeçalho. Um cabeçalho com base_ms menor que o tempo atual indica reset.
+// ============================================================================
+
+#ifndef LDR_TRACE_H
+#define LDR_TRACE_H
+
+#include <stdint.h>
+
+static const uint8_t TRACE_MAGIC[4] = {'L', 'D', 'R', 'T'};
+static const uint8_t TRACE_VERSION = 1;
+static const uint8_t TRACE_HEADER_SIZE = 12; // magic + versão + reservado + base_ms
+static const uint8_t TRACE_RECORD_SIZE = 4;
+static const uint16_t TRACE_MAX_DT_MS = 0xFFFE;
+static const uint16_t TRACE_SKIP_VALUE = 0xFFFF;
+static const uint8_t TRACE_SYNC_RECORDS = 64; // ~6s com o loop de 100ms
+
+// Escreve o cabeçalho em buf (TRACE_HEADER_SIZE bytes)
+inline void traceEncodeHeader(uint8_t *buf, uint32_t baseMs)
+{
+	buf[0] = TRACE_MAGIC[0];
+	buf[1] = TRACE_MAGIC[1];
+	buf[2] = TRACE_MAGIC[2];
+	buf[3] = TRACE_MAGIC[3];
+	buf[4] = TRACE_VERSION;
+	buf[5] = 0;
+	buf[6] = 0;
+	buf[7] = 0;
+	buf[8] = (uint8_t)(baseMs & 0xFF);
+	buf[9] = (uint8_t)((baseMs >> 8) & 0xFF);
+	buf[10] = (uint8_t)((baseMs >> 16) & 0xFF);
+	buf[11] = (uint8_t)((baseMs >> 24) & 0xFF);
+}
+
+// Escreve um registro em buf (TRACE_RECORD_SIZE bytes)
+inline void traceEncodeRecord(uint8_t *buf, uint16_t dtMs, uint16_t value)
+{
+	buf[0] = (uint8_t)(dtMs & 0xFF);
+	buf[1] = (uint8_t)(dtMs >> 8);
+	buf[2] = (uint8_t)(value & 0xFF);
+	buf[3] = (uint8_t)(value >> 8);
+}
+
+// Se dtMs não cabe em um registro, escreve em buf um registro de salto e
+// desconta TRACE_MAX_DT_MS de *dtMs. Retorna false quando o intervalo
+// restante já cabe no registro da amostra.
+inline bool traceEncodeSkip(uint8_t *buf, uint32_t *dtMs)
+{
+	if (*dtMs <= TRACE_MAX_DT_MS)
+	{
+		return false;
+	}
+	traceEncodeRecord(buf, TRACE_MAX_DT_MS, TRACE_SKIP_VALUE);
+	*dtMs -= TRACE_MAX_DT_MS;
+	return true;
+}
+
+inline uint32_t traceDecodeBase(const uint8_t *buf)
+{
+	return (uint32_t)buf[8] | ((uint32_t)buf[9] << 8) |
+		   ((uint32_t)buf[10] << 16) | ((uint32_t)buf[11] << 24);
+}
+
+inline void traceDecodeRecord(const uint8_t *buf, uint16_t *dtMs, uint16_t *value)
+{
+	*dtMs = (uint16_t)(buf[0] | (buf[1] << 8));
+	*value = (uint16_t)(buf[2] | (buf[3] << 8));
+}
+
+#endif // LDR_TRACE_H
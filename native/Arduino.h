@@ -0,0 +1,253 @@
+// ============================================================================
+// STUB ARDUINO PARA HOST (ambiente replay)
+// ============================================================================
+// Implementa apenas o subconjunto da API Arduino usado por
+// src/main_esp8266_mqtt.cpp, para que o firmware rode no PC alimentado por
+// um trace gravado. millis(), delay() e analogRead() são simulados pelo
+// driver de replay (src/replay_native.cpp).
+// ============================================================================
+
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+
+#define HEX 16
+#define DEC 10
+
+// Pinos usados pelo firmware (valores da NodeMCU)
+static const uint8_t A0 = 17;
+static const uint8_t D2 = 4;
+
+// Strings em flash não existem no host
+#define F(s) (s)
+
+// ============================================================================
+// TEMPO, GPIO E ADC (implementados pelo driver de replay)
+// ============================================================================
+unsigned long millis();
+uint64_t micros64();
+void delay(unsigned long ms);
+int analogRead(uint8_t pin);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+long random(long max);
+
+// SNTP não roda no host (ver coredecls.h)
+inline void configTime(int timezone, int daylightOffsetSec, const char *server1,
+					   const char *server2 = nullptr, const char *server3 = nullptr)
+{
+	(void)timezone;
+	(void)daylightOffsetSec;
+	(void)server1;
+	(void)server2;
+	(void)server3;
+}
+
+template <typename T>
+T constrain(T value, T low, T high)
+{
+	return value < low ? low : (value > high ? high : value);
+}
+
+// ============================================================================
+// STRING
+// ============================================================================
+class String
+{
+public:
+	String(const char *str = "") { *this = str; }
+	String(const std::string &str) : buffer(str) {}
+	String(char c) : buffer(1, c) {}
+	String(int value, unsigned char base = DEC) { fromNumber(value, base); }
+	String(unsigned int value, unsigned char base = DEC) { fromNumber(value, base); }
+	String(long value, unsigned char base = DEC) { fromNumber(value, base); }
+	String(unsigned long value, unsigned char base = DEC) { fromNumber(value, base); }
+
+	String &operator=(const char *str)
+	{
+		// ArduinoJson atribui nullptr para limpar a string
+		buffer = str ? str : "";
+		return *this;
+	}
+
+	const char *c_str() const { return buffer.c_str(); }
+	unsigned int length() const { return (unsigned int)buffer.length(); }
+	bool reserve(unsigned int size)
+	{
+		buffer.reserve(size);
+		return true;
+	}
+
+	bool concat(const char *str)
+	{
+		if (str)
+			buffer += str;
+		return true;
+	}
+	bool concat(const String &str)
+	{
+		buffer += str.buffer;
+		return true;
+	}
+	bool concat(char c)
+	{
+		buffer += c;
+		return true;
+	}
+
+	String &operator+=(const String &str)
+	{
+		concat(str);
+		return *this;
+	}
+	String &operator+=(const char *str)
+	{
+		concat(str);
+		return *this;
+	}
+	String &operator+=(char c)
+	{
+		concat(c);
+		return *this;
+	}
+
+	bool operator==(const String &other) const { return buffer == other.buffer; }
+	bool operator!=(const String &other) const { return buffer != other.buffer; }
+	bool operator==(const char *other) const { return buffer == (other ? other : ""); }
+	bool operator!=(const char *other) const { return !(*this == other); }
+
+	bool endsWith(const char *suffix) const
+	{
+		size_t n = strlen(suffix);
+		return buffer.size() >= n && buffer.compare(buffer.size() - n, n, suffix) == 0;
+	}
+
+private:
+	template <typename T>
+	void fromNumber(T value, unsigned char base)
+	{
+		char tmp[34];
+		if (base == HEX)
+			snprintf(tmp, sizeof(tmp), "%lx", (unsigned long)value);
+		else if (value < 0)
+			snprintf(tmp, sizeof(tmp), "%ld", (long)value);
+		else
+			snprintf(tmp, sizeof(tmp), "%lu", (unsigned long)value);
+		buffer = tmp;
+	}
+
+	std::string buffer;
+};
+
+// Tipo usado pelo Arduino para concatenações; ArduinoJson o referencia
+class StringSumHelper : public String
+{
+public:
+	StringSumHelper(const String &str) : String(str) {}
+};
+
+inline StringSumHelper operator+(const String &lhs, const String &rhs)
+{
+	StringSumHelper result(lhs);
+	result += rhs;
+	return result;
+}
+
+inline StringSumHelper operator+(const String &lhs, const char *rhs)
+{
+	StringSumHelper result(lhs);
+	result += rhs;
+	return result;
+}
+
+inline StringSumHelper operator+(const char *lhs, const String &rhs)
+{
+	StringSumHelper result{String(lhs)};
+	result += rhs;
+	return result;
+}
+
+// ============================================================================
+// SERIAL
+// ============================================================================
+// Saída descartada por padrão; o driver habilita com --verbose
+class HardwareSerial
+{
+public:
+	bool enabled = false;
+
+	void begin(unsigned long) {}
+
+	size_t write(const uint8_t *data, size_t size)
+	{
+		if (enabled)
+			fwrite(data, 1, size, stderr);
+		return size;
+	}
+
+	void print(const char *str)
+	{
+		if (enabled)
+			fputs(str, stderr);
+	}
+	void print(const String &str) { print(str.c_str()); }
+	void print(char c) { print(String(c)); }
+	void print(int value) { print(String(value)); }
+	void print(unsigned int value) { print(String(value)); }
+	void print(long value) { print(String(value)); }
+	void print(unsigned long value) { print(String(value)); }
+
+	template <typename T>
+	void println(const T &value)
+	{
+		print(value);
+		print("\n");
+	}
+	void println() { print("\n"); }
+};
+
+extern HardwareSerial Serial;
+
+// ============================================================================
+// ESP (memória RTC de usuário: 512 bytes, em blocos de 4 bytes)
+// ============================================================================
+// Sobrevive entre chamadas de setup() no mesmo processo, como num reset a
+// quente; zere-a com rtcUserMemoryWrite() para simular um power-on.
+class EspClass
+{
+public:
+	bool rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size)
+	{
+		if (offset * 4 + size > sizeof(rtcMemory))
+			return false;
+		memcpy(data, &rtcMemory[offset], size);
+		return true;
+	}
+
+	bool rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size)
+	{
+		if (offset * 4 + size > sizeof(rtcMemory))
+			return false;
+		memcpy(&rtcMemory[offset], data, size);
+		return true;
+	}
+
+private:
+	uint32_t rtcMemory[128] = {};
+};
+
+extern EspClass ESP;
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,48 @@
+// ============================================================================
+// STUB EEPROM PARA HOST (ambiente replay)
+// ============================================================================
+// Memória volátil: cada execução do replay começa como o primeiro boot.
+// commits conta as gravações (cada uma apagaria um setor da flash).
+// ============================================================================
+
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+class EEPROMClass
+{
+public:
+	void begin(size_t size) { data.resize(size, 0xFF); }
+	bool commit()
+	{
+		commits++;
+		return true;
+	}
+	bool end() { return true; }
+
+	template <typename T>
+	T &get(int address, T &value)
+	{
+		memcpy(&value, &data[address], sizeof(T));
+		return value;
+	}
+
+	template <typename T>
+	const T &put(int address, const T &value)
+	{
+		memcpy(&data[address], &value, sizeof(T));
+		return value;
+	}
+
+	unsigned long commits = 0;
+
+private:
+	std::vector<uint8_t> data;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // NATIVE_EEPROM_H
@@ -0,0 +1,49 @@
+// ============================================================================
+// STUB ESP8266WiFi PARA HOST (ambiente replay)
+// ============================================================================
+// WiFi sempre conectado, com IP e RSSI fixos, para que o replay seja
+// determinístico.
+// ============================================================================
+
+#ifndef NATIVE_ESP8266WIFI_H
+#define NATIVE_ESP8266WIFI_H
+
+#include <Arduino.h>
+
+enum wl_status_t
+{
+	WL_IDLE_STATUS = 0,
+	WL_CONNECTED = 3,
+	WL_DISCONNECTED = 6
+};
+
+enum WiFiMode_t
+{
+	WIFI_OFF = 0,
+	WIFI_STA = 1
+};
+
+class IPAddress
+{
+public:
+	String toString() const { return String("127.0.0.1"); }
+	operator String() const { return toString(); }
+};
+
+class ESP8266WiFiClass
+{
+public:
+	void mode(WiFiMode_t) {}
+	void begin(const char *, const char *) {}
+	wl_status_t status() const { return WL_CONNECTED; }
+	IPAddress localIP() const { return IPAddress(); }
+	int RSSI() const { return -50; }
+};
+
+extern ESP8266WiFiClass WiFi;
+
+class WiFiClient
+{
+};
+
+#endif // NATIVE_ESP8266WIFI_H
@@ -0,0 +1,81 @@
+// ============================================================================
+// STUB PubSubClient PARA HOST (ambiente replay)
+// ============================================================================
+// Não abre conexão: cada publish() é entregue ao hook do driver de replay,
+// que contabiliza as publicações. Mantém o limite de buffer da biblioteca
+// real para que payloads grandes falhem da mesma forma que no dispositivo.
+// ============================================================================
+
+#ifndef NATIVE_PUBSUBCLIENT_H
+#define NATIVE_PUBSUBCLIENT_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+#define MQTT_MAX_HEADER_SIZE 5
+
+class PubSubClient
+{
+public:
+	typedef void (*Callback)(char *topic, uint8_t *payload, unsigned int length);
+	typedef void (*PublishHook)(const char *topic, const char *payload, bool retained);
+
+	// Definido pelo driver de replay
+	static PublishHook onPublish;
+
+	explicit PubSubClient(WiFiClient &) {}
+
+	PubSubClient &setServer(const char *, uint16_t) { return *this; }
+	PubSubClient &setCallback(Callback cb)
+	{
+		callback = cb;
+		return *this;
+	}
+	PubSubClient &setKeepAlive(uint16_t) { return *this; }
+	PubSubClient &setSocketTimeout(uint16_t) { return *this; }
+	bool setBufferSize(uint16_t size)
+	{
+		bufferSize = size;
+		return true;
+	}
+	uint16_t getBufferSize() const { return bufferSize; }
+
+	bool connect(const char *, const char *, const char *, const char *, uint8_t, bool, const char *)
+	{
+		isConnected = true;
+		return true;
+	}
+	bool connected() const { return isConnected; }
+	int state() const { return isConnected ? 0 : -1; }
+	bool subscribe(const char *, uint8_t) { return isConnected; }
+	bool loop() { return isConnected; }
+
+	bool publish(const char *topic, const char *payload, bool retained)
+	{
+		if (!isConnected)
+			return false;
+		// Mesmo cálculo da biblioteca: cabeçalho + tamanho do tópico + tópico + payload
+		if (MQTT_MAX_HEADER_SIZE + 2 + strlen(topic) + strlen(payload) > bufferSize)
+			return false;
+		if (onPublish)
+			onPublish(topic, payload, retained);
+		return true;
+	}
+
+	// Entrega uma mensagem ao callback como se viesse do broker
+	void inject(const char *topic, const char *payload)
+	{
+		if (!callback)
+			return;
+		std::string topicCopy(topic);
+		std::string payloadCopy(payload);
+		callback(&topicCopy[0], (uint8_t *)&payloadCopy[0], (unsigned int)payloadCopy.size());
+	}
+
+private:
+	Callback callback = nullptr;
+	uint16_t bufferSize = 256;
+	bool isConnected = false;
+};
+
+#endif // NATIVE_PUBSUBCLIENT_H
@@ -0,0 +1,20 @@
+// ============================================================================
+// STUB coredecls.h PARA HOST (ambiente replay)
+// ============================================================================
+// O callback de sync nunca é chamado: no replay os timestamps ficam em
+// millis() simulado ("synced": false), mantendo a saída determinística.
+// ============================================================================
+
+#ifndef NATIVE_COREDECLS_H
+#define NATIVE_COREDECLS_H
+
+#include <stdint.h>
+
+extern "C" uint32_t sntp_update_delay_MS_rfc_not_less_than_15000();
+
+inline void settimeofday_cb(void (*cb)(bool))
+{
+	(void)cb;
+}
+
+#endif // NATIVE_COREDECLS_H
@@ -0,0 +1,132 @@
+// ============================================================================
+// LEITOR DE TRACE DO LDR (host)
+// ============================================================================
+// Decodifica um arquivo gravado da Serial no formato de include/ldr_trace.h.
+// Uma captura longa pode conter:
+// - lixo do boot antes do primeiro cabeçalho
+// - cabeçalhos de sincronismo (a cada TRACE_SYNC_RECORDS registros), que
+//   realinham o stream e corrigem o tempo
+// - cabeçalhos com millis() menor que o atual (reset do dispositivo): iniciam
+//   um novo segmento, cujo tempo continua após o segmento anterior
+// - bytes perdidos na UART, que desalinham os registros seguintes
+//
+// Um registro inválido (valor > TRACE_MAX_VALUE) indica perda de
+// alinhamento: os bytes são descartados até o próximo cabeçalho.
+// ============================================================================
+
+#ifndef LDR_TRACE_READER_H
+#define LDR_TRACE_READER_H
+
+#include <string.h>
+#include <vector>
+#include "ldr_trace.h"
+
+static const uint16_t TRACE_MAX_VALUE = 1024; // O ADC do ESP8266 pode retornar 1024
+
+struct TraceSample
+{
+	uint32_t ms; // Instante da leitura (millis() do dispositivo)
+	uint16_t value;
+};
+
+struct TraceReadStats
+{
+	unsigned long segments = 0;		  // Boots do dispositivo no trace (1 + resets)
+	unsigned long invalidRecords = 0; // Registros que quebraram o alinhamento
+	unsigned long prefixBytes = 0;	  // Lixo do boot antes do primeiro cabeçalho
+	unsigned long droppedBytes = 0;	  // Bytes descartados até o próximo cabeçalho
+};
+
+inline bool traceIsHeader(const std::vector<uint8_t> &data, size_t pos)
+{
+	return pos + TRACE_HEADER_SIZE <= data.size() &&
+		   memcmp(&data[pos], TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0 &&
+		   data[pos + 4] == TRACE_VERSION;
+}
+
+inline bool traceIsValidRecord(const std::vector<uint8_t> &data, size_t pos)
+{
+	if (pos + TRACE_RECORD_SIZE > data.size())
+	{
+		return false;
+	}
+
+	uint16_t dtMs;
+	uint16_t value;
+	traceDecodeRecord(&data[pos], &dtMs, &value);
+
+	// O firmware só grava saltos com o intervalo máximo
+	if (value == TRACE_SKIP_VALUE)
+	{
+		return dtMs == TRACE_MAX_DT_MS;
+	}
+	return value <= TRACE_MAX_VALUE;
+}
+
+// Retorna false se nenhum cabeçalho ou amostra foi encontrado
+inline bool traceRead(const std::vector<uint8_t> &data, std::vector<TraceSample> &samples, TraceReadStats &stats)
+{
+	size_t pos = 0;
+	bool aligned = false;
+	uint32_t deviceMs = 0; // millis() do dispositivo no registro atual
+	uint32_t offset = 0;   // Soma ao millis() para manter o tempo contínuo entre resets
+
+	while (pos < data.size())
+	{
+		if (traceIsHeader(data, pos))
+		{
+			uint32_t base = traceDecodeBase(&data[pos]);
+			if (stats.segments == 0)
+			{
+				stats.segments = 1;
+			}
+			else if (base < deviceMs)
+			{
+				// millis() voltou: o dispositivo reiniciou durante a captura
+				offset += deviceMs - base;
+				stats.segments++;
+			}
+			deviceMs = base;
+			aligned = true;
+			pos += TRACE_HEADER_SIZE;
+			continue;
+		}
+
+		if (aligned && traceIsValidRecord(data, pos))
+		{
+			uint16_t dtMs;
+			uint16_t value;
+			traceDecodeRecord(&data[pos], &dtMs, &value);
+			deviceMs += dtMs;
+			if (value != TRACE_SKIP_VALUE)
+			{
+				samples.push_back({deviceMs + offset, value});
+			}
+			pos += TRACE_RECORD_SIZE;
+			continue;
+		}
+
+		if (aligned)
+		{
+			aligned = false;
+			if (pos + TRACE_RECORD_SIZE <= data.size())
+			{
+				stats.invalidRecords++;
+			}
+		}
+
+		if (stats.segments == 0)
+		{
+			stats.prefixBytes++;
+		}
+		else
+		{
+			stats.droppedBytes++;
+		}
+		pos++;
+	}
+
+	return stats.segments > 0 && !samples.empty();
+}
+
+#endif // LDR_TRACE_READER_H
@@ -13,10 +13,37 @@
 // ============================================================================
 
 #include <Arduino.h>
+#include <EEPROM.h>
 #include <ESP8266WiFi.h>
 #include <PubSubClient.h>
 #include <ArduinoJson.h>
-#include "config.h" // Configurações WiFi, MQTT e identificação
+#include <coredecls.h> // settimeofday_cb()
+#include <sys/time.h>
+#include <time.h>
+#include "config.h"	  // Configurações WiFi, MQTT e identificação
+#include "ldr_trace.h" // Formato binário de trace do LDR
+
+// ============================================================================
+// CAPTURA DE TRACE DO SENSOR
+// ============================================================================
+// 0 = Operação normal
+// 1 = Transmite cada leitura bruta do LDR pela Serial em formato binário
+//     (ver include/ldr_trace.h) para replay no host. Os logs de debug são
+//     desabilitados para não corromper o stream (ambiente esp8266_trace).
+#ifndef TRACE_CAPTURE
+#define TRACE_CAPTURE 0
+#endif
+
+// ============================================================================
+// STREAMING LOCAL
+// ============================================================================
+// 0 = Desabilitado (padrão)
+// 1 = Servidor TCP na rede local, sem autenticação, que envia cada amostra
+//     filtrada e cada mudança de status (JSON por linha), sem passar pelo
+//     broker MQTT (ambiente esp8266_stream)
+#ifndef LOCAL_STREAM
+#define LOCAL_STREAM 0
+#endif
 
 // ============================================================================
 // DEBUG LEVELS
@@ -25,7 +52,11 @@
 // 1 = Apenas erros
 // 2 = Informações importantes (padrão)
 // 3 = Modo verbose (todos os logs)
+#if TRACE_CAPTURE
+#define DEBUG_LEVEL 0 // Serial reservada para o stream de trace
+#else
 #define DEBUG_LEVEL 3
+#endif
 
 // Macros para controle de debug
 #if DEBUG_LEVEL >= 1
@@ -78,6 +109,25 @@ Thresholds thresholds = {
 	950	 // light_critical: > 950 = luz excessiva
 };
 
+// ============================================================================
+// SINCRONIZAÇÃO DE TEMPO (SNTP)
+// ============================================================================
+// Timestamps ("ts") em milissegundos desde a epoch UTC. Antes do primeiro
+// sync são milissegundos desde o boot ("synced": false).
+static const char *NTP_SERVER_1 = "pool.ntp.org";
+static const char *NTP_SERVER_2 = "time.nist.gov";
+static const uint32_t NTP_SYNC_INTERVAL = 900000; // 15 minutos
+static const int32_t MAX_DRIFT_PPM = 500;		  // Deriva máxima aceita do cristal
+
+// Contador de boots persistido na EEPROM: identifica a sequência "seq" de
+// cada boot, já que ela reinicia a cada reboot
+static const uint16_t EEPROM_SIZE = 8;
+static const int EEPROM_BOOT_MAGIC_ADDR = 0;
+static const int EEPROM_BOOT_COUNT_ADDR = 4; // Último número de boot reservado
+static const uint32_t BOOT_MAGIC = 0x4C445242; // "LDRB"
+static const uint32_t BOOT_BLOCK = 16;		   // Números reservados por escrita na flash
+static const uint32_t RTC_BOOT_OFFSET = 32;	   // Blocos 0-31 da memória RTC são do OTA
+
 // ============================================================================
 // TÓPICOS MQTT
 // ============================================================================
@@ -111,10 +161,27 @@ const unsigned long TELEMETRY_INTERVAL = 3000; // 3 segundos
 unsigned long lastReconnectAttempt = 0;
 const unsigned long RECONNECT_INTERVAL = 5000;
 
-unsigned long startTime = 0;
 unsigned long telemetryCount = 0;
 bool telemetryEnabled = false; // Telemetria só inicia após comando get_status
 
+bool timeSynced = false;
+uint64_t syncEpochMs = 0;	  // Epoch (ms) recebida no último sync SNTP
+uint64_t syncUptimeMs = 0;	  // Uptime (ms) no último sync SNTP
+int32_t driftPpm = 0;		  // Deriva estimada do uptime em relação ao SNTP
+uint64_t lastTimestamp = 0;	  // Garante timestamps monotônicos
+uint32_t messageSeq = 0;	  // Sequência por dispositivo (telemetry, event, config)
+uint32_t bootCount = 0;		  // Número do boot atual (persistido na EEPROM)
+
+#if LOCAL_STREAM
+static const uint16_t STREAM_PORT = 8888;
+static const uint8_t STREAM_MAX_CLIENTS = 3;
+static const uint8_t STREAM_MAX_DROPS = 20; // Descartes seguidos antes de desconectar o cliente
+
+WiFiServer streamServer(STREAM_PORT);
+WiFiClient streamClients[STREAM_MAX_CLIENTS];
+uint8_t streamDrops[STREAM_MAX_CLIENTS];
+#endif
+
 // ============================================================================
 // DECLARAÇÕES FORWARD
 // ============================================================================
@@ -124,6 +191,173 @@ void processCommand(String command);
 String classifyStatus(int value);
 bool determineLedState(int ldrValue);
 
+// ============================================================================
+// TEMPO E SEQUÊNCIA
+// ============================================================================
+
+// Intervalo entre syncs SNTP (substitui a função weak do core, padrão 1h).
+// Precisa de linkagem C para sobrescrever o símbolo do core.
+extern "C" uint32_t sntp_update_delay_MS_rfc_not_less_than_15000()
+{
+	return NTP_SYNC_INTERVAL;
+}
+
+// Uptime em ms de 64 bits: millis() dá a volta após ~49,7 dias
+uint64_t uptimeMs()
+{
+	return micros64() / 1000;
+}
+
+// Epoch (ms) estimada a partir do último sync, corrigida pela deriva
+uint64_t localEpochMs(uint64_t nowMs)
+{
+	int64_t elapsed = (int64_t)(nowMs - syncUptimeMs);
+	return syncEpochMs + elapsed + (elapsed * driftPpm) / 1000000;
+}
+
+// Atualiza a referência de tempo e a estimativa de deriva com um sync
+void applyTimeSync(uint64_t epochMs, uint64_t nowMs)
+{
+	// Compara a previsão local com o SNTP para estimar a deriva do cristal
+	int64_t elapsed = (int64_t)(nowMs - syncUptimeMs);
+	if (timeSynced && elapsed >= 60000)
+	{
+		int64_t error = (int64_t)(epochMs - localEpochMs(nowMs));
+		int64_t measured = driftPpm + error * 1000000 / elapsed;
+
+		DEBUG_VERBOSE(F("[SNTP] Erro: "));
+		DEBUG_VERBOSE((long)error);
+
+		// Fora do limite do cristal é um ajuste de relógio, não deriva
+		if (measured >= -MAX_DRIFT_PPM && measured <= MAX_DRIFT_PPM)
+		{
+			driftPpm = (driftPpm + (int32_t)measured) / 2; // Filtro simples contra jitter de rede
+			DEBUG_VERBOSE(F(" ms | Deriva: "));
+			DEBUG_VERBOSE(driftPpm);
+			DEBUG_VERBOSELN(F(" ppm"));
+		}
+		else
+		{
+			DEBUG_VERBOSELN(F(" ms | Salto de relógio, deriva mantida"));
+		}
+	}
+
+	syncEpochMs = epochMs;
+	syncUptimeMs = nowMs;
+	if (!timeSynced)
+	{
+		timeSynced = true;
+		DEBUG_INFOLN(F("[SNTP] ✓ Horário sincronizado"));
+	}
+}
+
+void onTimeSync(bool fromSntp)
+{
+	if (!fromSntp)
+	{
+		return;
+	}
+
+	struct timeval tv;
+	gettimeofday(&tv, nullptr);
+	applyTimeSync((uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000, uptimeMs());
+}
+
+// Timestamp em ms (epoch UTC se sincronizado), nunca decrescente: se um
+// sync atrasar o relógio, o valor fica parado até o tempo alcançá-lo
+uint64_t timestampMs()
+{
+	uint64_t now = uptimeMs();
+	uint64_t ts = timeSynced ? localEpochMs(now) : now;
+	if (ts < lastTimestamp)
+	{
+		ts = lastTimestamp;
+	}
+	lastTimestamp = ts;
+	return ts;
+}
+
+// Reserva de números de boot guardada na memória RTC (sobrevive a resets,
+// não a quedas de energia)
+struct RtcBootBlock
+{
+	uint32_t magic;
+	uint32_t next; // Próximo número de boot livre
+	uint32_t last; // Último número reservado na EEPROM
+	uint32_t check;
+};
+
+void saveRtcBootBlock(uint32_t next, uint32_t last)
+{
+	RtcBootBlock rtc = {BOOT_MAGIC, next, last, BOOT_MAGIC ^ next ^ last};
+	ESP.rtcUserMemoryWrite(RTC_BOOT_OFFSET, (uint32_t *)&rtc, sizeof(rtc));
+}
+
+// Incrementa o contador de boots.
+// Cada commit() da EEPROM apaga um setor inteiro da flash, e um boot loop
+// (watchdog, crash) gastaria a flash rapidamente. Por isso a EEPROM reserva
+// BOOT_BLOCK números por vez e a memória RTC guarda o restante da reserva:
+// resets a quente não escrevem na flash, apenas o power-on e o fim da
+// reserva. Em troca, após uma queda de energia os números ainda não usados
+// são perdidos e "boot" salta, mas nunca se repete.
+void loadBootCount()
+{
+	RtcBootBlock rtc;
+	if (ESP.rtcUserMemoryRead(RTC_BOOT_OFFSET, (uint32_t *)&rtc, sizeof(rtc)) &&
+		rtc.magic == BOOT_MAGIC && rtc.check == (BOOT_MAGIC ^ rtc.next ^ rtc.last) &&
+		rtc.next <= rtc.last)
+	{
+		bootCount = rtc.next;
+		saveRtcBootBlock(bootCount + 1, rtc.last);
+	}
+	else
+	{
+		uint32_t magic = 0;
+		uint32_t last = 0;
+		EEPROM.begin(EEPROM_SIZE);
+		EEPROM.get(EEPROM_BOOT_MAGIC_ADDR, magic);
+		EEPROM.get(EEPROM_BOOT_COUNT_ADDR, last);
+
+		// EEPROM nunca inicializada
+		if (magic != BOOT_MAGIC)
+		{
+			last = 0;
+			EEPROM.put(EEPROM_BOOT_MAGIC_ADDR, BOOT_MAGIC);
+		}
+
+		bootCount = last + 1;
+		last += BOOT_BLOCK;
+		EEPROM.put(EEPROM_BOOT_COUNT_ADDR, last);
+		if (EEPROM.commit())
+		{
+			saveRtcBootBlock(bootCount + 1, last);
+		}
+		else
+		{
+			DEBUG_ERRORLN(F("[BOOT] ✗ Falha ao gravar contador de boots"));
+		}
+		EEPROM.end();
+	}
+
+	DEBUG_INFO(F("[BOOT] Boot #"));
+	DEBUG_INFOLN(bootCount);
+}
+
+// Adiciona ts, synced e boot (mensagens de estado: state e lwt)
+void stampTime(JsonDocument &doc)
+{
+	doc["ts"] = timestampMs();
+	doc["synced"] = timeSynced;
+	doc["boot"] = bootCount;
+}
+
+// Adiciona ts, synced, boot e seq (telemetry, event e config)
+void stampMessage(JsonDocument &doc)
+{
+	stampTime(doc);
+	doc["seq"] = ++messageSeq;
+}
+
 // ============================================================================
 // FUNÇÕES MQTT
 // ============================================================================
@@ -288,7 +522,7 @@ bool connectMQTT()
 	// Prepara Last Will Testament (LWT)
 	StaticJsonDocument<128> lwtDoc;
 	lwtDoc["status"] = "offline";
-	lwtDoc["ts"] = startTime + (millis() / 1000);
+	stampTime(lwtDoc); // ts do momento da conexão
 	String lwtPayload;
 	serializeJson(lwtDoc, lwtPayload);
 
@@ -314,7 +548,7 @@ bool connectMQTT()
 		// Publica estado online
 		StaticJsonDocument<256> onlineDoc;
 		onlineDoc["status"] = "online";
-		onlineDoc["ts"] = startTime + (millis() / 1000);
+		stampTime(onlineDoc);
 		onlineDoc["ip"] = WiFi.localIP().toString();
 		onlineDoc["rssi"] = WiFi.RSSI();
 
@@ -371,10 +605,57 @@ void connectWiFi()
 // SENSOR E CLASSIFICAÇÃO
 // ============================================================================
 
+#if TRACE_CAPTURE
+unsigned long lastTraceTime = 0;
+uint8_t traceRecords = 0; // Registros desde o último cabeçalho
+
+void traceBegin()
+{
+	uint8_t header[TRACE_HEADER_SIZE];
+	traceRecords = 0;
+	lastTraceTime = millis();
+	traceEncodeHeader(header, lastTraceTime);
+	Serial.write(header, sizeof(header));
+}
+
+void traceSample(int value)
+{
+	uint8_t record[TRACE_RECORD_SIZE];
+
+	// Cabeçalho periódico para o leitor se realinhar após bytes perdidos
+	if (traceRecords >= TRACE_SYNC_RECORDS)
+	{
+		traceBegin();
+	}
+	unsigned long now = millis();
+	uint32_t dt = now - lastTraceTime;
+	lastTraceTime = now;
+
+	// Intervalos longos (ex: reconexão WiFi) viram registros de salto
+	while (traceEncodeSkip(record, &dt))
+	{
+		Serial.write(record, sizeof(record));
+	}
+
+	traceEncodeRecord(record, (uint16_t)dt, (uint16_t)value);
+	Serial.write(record, sizeof(record));
+	traceRecords++;
+}
+#endif
+
+int readLdr()
+{
+	int value = analogRead(LDR_PIN);
+#if TRACE_CAPTURE
+	traceSample(value);
+#endif
+	return value;
+}
+
 int getMovingAverage()
 {
 	total = total - readings[readIndex];
-	readings[readIndex] = analogRead(LDR_PIN);
+	readings[readIndex] = readLdr();
 	total = total + readings[readIndex];
 	readIndex = (readIndex + 1) % SAMPLE_SIZE;
 	return total / SAMPLE_SIZE;
@@ -423,8 +704,7 @@ void publishTelemetry(bool forcePublish = false)
 	}
 	StaticJsonDocument<512> doc;
 
-	unsigned long timestamp = startTime + (millis() / 1000);
-	doc["ts"] = timestamp;
+	stampMessage(doc);
 	doc["cellId"] = CELL_ID;
 	doc["devId"] = DEVICE_ID;
 
@@ -507,7 +787,7 @@ void publishEvent(String eventType, String description)
 	}
 
 	StaticJsonDocument<256> doc;
-	doc["ts"] = startTime + (millis() / 1000);
+	stampMessage(doc);
 	doc["event"] = eventType;
 	doc["description"] = description;
 	doc["ldr"] = average;
@@ -541,7 +821,7 @@ void publishConfig()
 	}
 
 	StaticJsonDocument<256> doc;
-	doc["ts"] = startTime + (millis() / 1000);
+	stampMessage(doc);
 
 	JsonObject thresh = doc["thresholds"].to<JsonObject>();
 	thresh["dark_critical"] = thresholds.dark_critical;
@@ -564,6 +844,120 @@ void publishConfig()
 	}
 }
 
+// ============================================================================
+// STREAMING LOCAL
+// ============================================================================
+// Clientes conectam via TCP (ex: nc <ip> 8888) e recebem uma linha JSON por
+// amostra. Os clientes operam em modo assíncrono (setSync(false)), em que
+// write() não espera o ACK, e só se escreve quando a linha cabe no buffer de
+// envio; caso contrário ela é descartada para aquele cliente. Clientes são
+// desconectados com abort() (RST imediato): stop() faria flush() e esperaria
+// o ACK por até 300ms. Assim um cliente lento ou desaparecido nunca trava o
+// loop().
+
+#if LOCAL_STREAM
+void setupStream()
+{
+	streamServer.begin();
+	streamServer.setNoDelay(true);
+
+	DEBUG_INFO(F("✓ Streaming local na porta "));
+	DEBUG_INFOLN(STREAM_PORT);
+}
+
+// Escreve sem bloquear: retorna false se a linha não cabe no buffer de envio
+bool streamWrite(WiFiClient &client, const char *line, size_t len)
+{
+	if ((size_t)client.availableForWrite() < len)
+	{
+		return false;
+	}
+	client.write((const uint8_t *)line, len);
+	return true;
+}
+
+void acceptStreamClients()
+{
+	WiFiClient incoming = streamServer.accept();
+	if (!incoming)
+	{
+		return;
+	}
+
+	// Modo síncrono (padrão do core) faria write() esperar o ACK por até ~5s
+	incoming.setSync(false);
+
+	for (uint8_t i = 0; i < STREAM_MAX_CLIENTS; i++)
+	{
+		if (!streamClients[i].connected())
+		{
+			streamClients[i] = incoming;
+			streamClients[i].setNoDelay(true);
+			streamDrops[i] = 0;
+
+			char hello[128];
+			int len = snprintf(hello, sizeof(hello), "{\"devId\":\"%s\",\"status\":\"%s\"}\n",
+							   DEVICE_ID, currentStatus.c_str());
+			if (len >= (int)sizeof(hello))
+			{
+				len = sizeof(hello) - 1; // DEVICE_ID muito longo: linha truncada
+			}
+			if (!streamWrite(streamClients[i], hello, len))
+			{
+				streamDrops[i]++;
+			}
+
+			DEBUG_INFO(F("[STREAM] Cliente conectado: "));
+			DEBUG_INFOLN(incoming.remoteIP());
+			return;
+		}
+	}
+
+	// Sem vagas: recusa o cliente (a resposta é best-effort, o RST pode descartá-la)
+	static const char busy[] = "{\"error\":\"busy\"}\n";
+	streamWrite(incoming, busy, sizeof(busy) - 1);
+	incoming.abort();
+	DEBUG_ERRORLN(F("[STREAM] ✗ Limite de clientes atingido"));
+}
+
+void streamBroadcast(const char *line, size_t len)
+{
+	for (uint8_t i = 0; i < STREAM_MAX_CLIENTS; i++)
+	{
+		if (!streamClients[i].connected())
+		{
+			continue;
+		}
+
+		if (streamWrite(streamClients[i], line, len))
+		{
+			streamDrops[i] = 0;
+		}
+		else if (++streamDrops[i] >= STREAM_MAX_DROPS)
+		{
+			DEBUG_ERRORLN(F("[STREAM] ✗ Cliente lento desconectado"));
+			streamClients[i].abort();
+		}
+	}
+}
+
+void streamSample()
+{
+	char line[96];
+	int len = snprintf(line, sizeof(line), "{\"t\":%lu,\"ldr\":%d,\"status\":\"%s\",\"led\":%d}\n",
+					   millis(), average, currentStatus.c_str(), ledState ? 1 : 0);
+	streamBroadcast(line, len);
+}
+
+void streamStatusChange()
+{
+	char line[112];
+	int len = snprintf(line, sizeof(line), "{\"t\":%lu,\"event\":\"status_change\",\"from\":\"%s\",\"to\":\"%s\"}\n",
+					   millis(), previousStatus.c_str(), currentStatus.c_str());
+	streamBroadcast(line, len);
+}
+#endif
+
 // ============================================================================
 // FUNÇÕES DE CONEXÃO
 // ============================================================================
@@ -611,18 +1005,25 @@ void setup()
 	DEBUG_INFOLN(F("║  Arduino ESP8266 WiFi - Sistema IoT                       ║"));
 	DEBUG_INFOLN(F("╚════════════════════════════════════════════════════════════╝"));
 
+#if TRACE_CAPTURE
+	traceBegin();
+#endif
+
 	// Inicializa array de leituras
 	for (int i = 0; i < SAMPLE_SIZE; i++)
 	{
-		readings[i] = analogRead(LDR_PIN);
+		readings[i] = readLdr();
 		total += readings[i];
 		delay(50);
 	}
 	average = total / SAMPLE_SIZE;
 
-	startTime = millis() / 1000;
-
 	setupTopics();
+	loadBootCount();
+
+	// Sincronização SNTP (UTC) - roda em segundo plano após o WiFi conectar
+	settimeofday_cb(onTimeSync);
+	configTime(0, 0, NTP_SERVER_1, NTP_SERVER_2);
 
 	// Conecta WiFi
 	connectWiFi();
@@ -640,6 +1041,10 @@ void setup()
 		connectMQTT();
 	}
 
+#if LOCAL_STREAM
+	setupStream();
+#endif
+
 	DEBUG_INFOLN(F("\n✓ Sistema iniciado!"));
 	DEBUG_INFOLN(F("------------------------------------------------------------"));
 	DEBUG_INFOLN(F("⏸️  Telemetria em espera - envie comando 'get_status' para iniciar"));
@@ -678,9 +1083,20 @@ void loop()
 
 	unsigned long now = millis();
 	bool shouldPublish = false;
+	bool statusChanged = currentStatus != previousStatus && previousStatus != "";
+
+#if LOCAL_STREAM
+	// Streaming local antes do MQTT, que pode bloquear no broker remoto
+	acceptStreamClients();
+	if (statusChanged)
+	{
+		streamStatusChange();
+	}
+	streamSample();
+#endif
 
 	// Detecta mudança de status primeiro
-	if (currentStatus != previousStatus && previousStatus != "")
+	if (statusChanged)
 	{
 		DEBUG_INFO(F("\n[STATUS CHANGE] "));
 		DEBUG_INFO(previousStatus);
@@ -0,0 +1,318 @@
+// ============================================================================
+// REPLAY DE TRACE DO LDR - Driver nativo (host)
+// ============================================================================
+// Executa setup()/loop() de main_esp8266_mqtt.cpp no PC, alimentando
+// analogRead() com um trace gravado pelo ambiente esp8266_trace
+// (formato em include/ldr_trace.h). O relógio é simulado: cada leitura
+// consome a próxima amostra do trace e avança millis() até o instante em
+// que ela foi gravada, então um dia inteiro roda em segundos.
+//
+// Uso:
+//   pio run -e replay
+//   .pio/build/replay/program <trace.ldrt> [opções]
+//
+// Opções:
+//   --idle                  Não envia get_status (telemetria fica desligada)
+//   --thresholds a,b,c,d    Envia set_thresholds antes do replay (sai com
+//                           status 2 se o firmware rejeitar os valores)
+//   --list                  Lista cada transição e evento com timestamp
+//   --verbose               Mostra os logs Serial do firmware (stderr)
+//
+// Testes (test/): pio test -e replay
+// ============================================================================
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <ESP8266WiFi.h>
+#include <PubSubClient.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "ldr_trace_reader.h"
+
+// ============================================================================
+// SÍMBOLOS DO FIRMWARE
+// ============================================================================
+void setup();
+void loop();
+extern PubSubClient mqttClient;
+extern char TOPIC_CMD[];
+extern String currentStatus;
+extern int average;
+
+// ============================================================================
+// ESTADO DA SIMULAÇÃO
+// ============================================================================
+struct ReplayStats
+{
+	unsigned long loops = 0;
+	unsigned long transitions = 0;
+	unsigned long ledToggles = 0;
+	std::map<std::string, unsigned long> publishes; // por sufixo de tópico
+	std::map<std::string, unsigned long> transitionsByKind;
+};
+
+HardwareSerial Serial;
+EspClass ESP;
+EEPROMClass EEPROM;
+ESP8266WiFiClass WiFi;
+PubSubClient::PublishHook PubSubClient::onPublish = nullptr;
+
+static std::vector<TraceSample> samples;
+static TraceReadStats traceStats;
+static size_t nextSample = 0;
+static unsigned long simMillis = 0;
+static unsigned long lastReadMillis = 0; // Instante da última leitura do ADC
+static int ledLevel = -1;
+static bool listEvents = false;
+static std::mt19937 rng(1); // Semente fixa: replay determinístico
+static ReplayStats stats;
+static FILE *out = stdout; // Relatório e --list
+
+// ============================================================================
+// API ARDUINO SIMULADA
+// ============================================================================
+
+unsigned long millis()
+{
+	return simMillis;
+}
+
+uint64_t micros64()
+{
+	return (uint64_t)simMillis * 1000;
+}
+
+void delay(unsigned long ms)
+{
+	simMillis += ms;
+}
+
+int analogRead(uint8_t pin)
+{
+	(void)pin;
+	if (samples.empty())
+	{
+		return 0;
+	}
+
+	// Após o fim do trace, repete a última amostra até o loop atual terminar
+	const TraceSample &sample = samples[nextSample < samples.size() ? nextSample : samples.size() - 1];
+	if (nextSample < samples.size())
+	{
+		nextSample++;
+	}
+	if (sample.ms > simMillis)
+	{
+		simMillis = sample.ms;
+	}
+	lastReadMillis = simMillis;
+	return sample.value;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+	(void)pin;
+	(void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+	if (pin != D2)
+	{
+		return;
+	}
+	if (ledLevel >= 0 && ledLevel != value)
+	{
+		stats.ledToggles++;
+		if (listEvents)
+		{
+			fprintf(out, "[%10lu ms] LED %s\n", simMillis, value ? "ON" : "OFF");
+		}
+	}
+	ledLevel = value;
+}
+
+long random(long max)
+{
+	return max > 0 ? (long)(rng() % (unsigned long)max) : 0;
+}
+
+// ============================================================================
+// CARREGAMENTO DO TRACE
+// ============================================================================
+
+static bool loadTrace(const char *path)
+{
+	FILE *file = fopen(path, "rb");
+	if (!file)
+	{
+		fprintf(stderr, "Erro: não foi possível abrir %s\n", path);
+		return false;
+	}
+
+	std::vector<uint8_t> data;
+	uint8_t chunk[4096];
+	size_t n;
+	while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+	{
+		data.insert(data.end(), chunk, chunk + n);
+	}
+	fclose(file);
+
+	if (!traceRead(data, samples, traceStats))
+	{
+		fprintf(stderr, "Erro: nenhum cabeçalho LDRT v%u com amostras em %s\n", TRACE_VERSION, path);
+		return false;
+	}
+	if (traceStats.invalidRecords > 0 || traceStats.segments > 1)
+	{
+		fprintf(stderr, "Aviso: trace com %lu segmento(s), %lu registro(s) inválido(s) e %lu byte(s) descartado(s)\n",
+				traceStats.segments, traceStats.invalidRecords, traceStats.droppedBytes);
+	}
+	return true;
+}
+
+// ============================================================================
+// OBSERVAÇÃO DAS PUBLICAÇÕES
+// ============================================================================
+
+static void onPublish(const char *topic, const char *payload, bool retained)
+{
+	(void)retained;
+	const char *suffix = strrchr(topic, '/');
+	std::string kind = suffix ? suffix + 1 : topic;
+	stats.publishes[kind]++;
+
+	if (listEvents && kind == "event")
+	{
+		fprintf(out, "[%10lu ms] EVENT %s\n", simMillis, payload);
+	}
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+// Roda o replay com os argumentos da linha de comando e escreve o relatório
+// em output. Retorna o código de saída do programa.
+int runReplay(int argc, char **argv, FILE *output)
+{
+	const char *tracePath = nullptr;
+	const char *thresholdArg = nullptr;
+	bool idle = false;
+	out = output;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--idle") == 0)
+			idle = true;
+		else if (strcmp(argv[i], "--list") == 0)
+			listEvents = true;
+		else if (strcmp(argv[i], "--verbose") == 0)
+			Serial.enabled = true;
+		else if (strcmp(argv[i], "--thresholds") == 0 && i + 1 < argc)
+			thresholdArg = argv[++i];
+		else if (!tracePath && argv[i][0] != '-')
+			tracePath = argv[i];
+		else
+		{
+			fprintf(stderr, "Argumento inválido: %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	if (!tracePath)
+	{
+		fprintf(stderr, "Uso: %s <trace.ldrt> [--idle] [--thresholds a,b,c,d] [--list] [--verbose]\n", argv[0]);
+		return 2;
+	}
+	if (!loadTrace(tracePath))
+	{
+		return 1;
+	}
+
+	PubSubClient::onPublish = onPublish;
+	setup();
+
+	if (thresholdArg)
+	{
+		int t[4];
+		if (sscanf(thresholdArg, "%d,%d,%d,%d", &t[0], &t[1], &t[2], &t[3]) != 4)
+		{
+			fprintf(stderr, "Erro: --thresholds espera 4 valores (a,b,c,d)\n");
+			return 2;
+		}
+		char cmd[160];
+		snprintf(cmd, sizeof(cmd),
+				 "{\"cmd\":\"set_thresholds\",\"dark_critical\":%d,\"dark_attention\":%d,"
+				 "\"light_attention\":%d,\"light_critical\":%d}",
+				 t[0], t[1], t[2], t[3]);
+
+		// O firmware só publica config se aceitar os thresholds
+		unsigned long configsBefore = stats.publishes["config"];
+		mqttClient.inject(TOPIC_CMD, cmd);
+		if (stats.publishes["config"] == configsBefore)
+		{
+			fprintf(stderr, "Erro: thresholds rejeitados pelo firmware (fora de 0-1023 ou fora de ordem; veja --verbose)\n");
+			return 2;
+		}
+	}
+	if (!idle)
+	{
+		mqttClient.inject(TOPIC_CMD, "{\"cmd\":\"get_status\"}");
+	}
+
+	String lastStatus = currentStatus;
+	while (nextSample < samples.size())
+	{
+		loop();
+		stats.loops++;
+
+		if (currentStatus != lastStatus)
+		{
+			stats.transitions++;
+			stats.transitionsByKind[std::string(lastStatus.c_str()) + " -> " + currentStatus.c_str()]++;
+			// Usa o instante da leitura que causou a transição (antes do delay do loop)
+			if (listEvents)
+			{
+				fprintf(out, "[%10lu ms] STATUS %s -> %s (ldr=%d)\n",
+					   lastReadMillis, lastStatus.c_str(), currentStatus.c_str(), average);
+			}
+			lastStatus = currentStatus;
+		}
+	}
+
+	unsigned long durationMs = samples.back().ms - samples.front().ms;
+	fprintf(out, "\n====================================\n");
+	fprintf(out, "REPLAY: %s\n", tracePath);
+	fprintf(out, "====================================\n");
+	fprintf(out, "Amostras:             %zu\n", samples.size());
+	fprintf(out, "Segmentos (resets):   %lu\n", traceStats.segments);
+	fprintf(out, "Registros inválidos:  %lu\n", traceStats.invalidRecords);
+	fprintf(out, "Bytes descartados:    %lu (+%lu antes do cabeçalho)\n", traceStats.droppedBytes, traceStats.prefixBytes);
+	fprintf(out, "Duração gravada:      %02lu:%02lu:%02lu\n",
+				 durationMs / 3600000, (durationMs / 60000) % 60, (durationMs / 1000) % 60);
+	fprintf(out, "Loops executados:     %lu\n", stats.loops);
+	fprintf(out, "Transições de status: %lu\n", stats.transitions);
+	for (const auto &kind : stats.transitionsByKind)
+	{
+		fprintf(out, "  %-24s %lu\n", kind.first.c_str(), kind.second);
+	}
+	fprintf(out, "Eventos publicados:   %lu\n", stats.publishes["event"]);
+	fprintf(out, "Toggles do LED:       %lu\n", stats.ledToggles);
+	fprintf(out, "Publicações MQTT:\n");
+	for (const auto &topic : stats.publishes)
+	{
+		fprintf(out, "  %-24s %lu\n", topic.first.c_str(), topic.second);
+	}
+	return 0;
+}
+
+#ifndef PIO_UNIT_TESTING // Os testes têm o próprio main() (Unity)
+int main(int argc, char **argv)
+{
+	return runReplay(argc, argv, stdout);
+}
+#endif
@@ -0,0 +1,62 @@
+// ============================================================================
+// TESTE DE REPLAY (src/replay_native.cpp + firmware)
+// ============================================================================
+// Reproduz sample.ldrt e compara o relatório com sample_summary.txt.
+// O trace tem lixo de boot antes do cabeçalho, cabeçalhos de sincronismo,
+// um intervalo de 150 s (registros de salto) e um reset do dispositivo.
+//
+// Se uma mudança no firmware alterar o comportamento de propósito, gere o
+// relatório de novo e revise a diferença antes de commitar:
+//   .pio/build/replay/program test/test_replay/sample.ldrt > test/test_replay/sample_summary.txt
+// ============================================================================
+
+#include <unity.h>
+#include <stdio.h>
+#include <string>
+
+static const char *TRACE_PATH = "test/test_replay/sample.ldrt"; // Relativo à raiz do projeto
+static const char *SUMMARY_PATH = "test/test_replay/sample_summary.txt";
+
+int runReplay(int argc, char **argv, FILE *output);
+
+static std::string readAll(FILE *file)
+{
+	std::string text;
+	char chunk[512];
+	size_t n;
+	while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+	{
+		text.append(chunk, n);
+	}
+	return text;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_sample_trace_summary()
+{
+	FILE *expectedFile = fopen(SUMMARY_PATH, "rb");
+	TEST_ASSERT_NOT_NULL(expectedFile);
+	std::string expected = readAll(expectedFile);
+	fclose(expectedFile);
+
+	FILE *report = tmpfile();
+	TEST_ASSERT_NOT_NULL(report);
+	char *argv[] = {(char *)"program", (char *)TRACE_PATH};
+	TEST_ASSERT_EQUAL_INT(0, runReplay(2, argv, report));
+
+	rewind(report);
+	std::string actual = readAll(report);
+	fclose(report);
+	TEST_ASSERT_EQUAL_STRING(expected.c_str(), actual.c_str());
+}
+
+int main(int argc, char **argv)
+{
+	(void)argc;
+	(void)argv;
+	UNITY_BEGIN();
+	RUN_TEST(test_sample_trace_summary);
+	return UNITY_END();
+}
@@ -0,0 +1,195 @@
+// ============================================================================
+// TESTES DE TIMESTAMP, SEQUÊNCIA E CONTADOR DE BOOTS (firmware no host)
+// ============================================================================
+// pio test -e replay -f test_time
+//
+// O relógio é o simulado pelo driver de replay: delay() avança o uptime.
+// ============================================================================
+
+#include <unity.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <EEPROM.h>
+
+// ============================================================================
+// SÍMBOLOS DO FIRMWARE
+// ============================================================================
+extern bool timeSynced;
+extern uint64_t syncEpochMs;
+extern uint64_t syncUptimeMs;
+extern int32_t driftPpm;
+extern uint64_t lastTimestamp;
+extern uint32_t messageSeq;
+extern uint32_t bootCount;
+uint64_t uptimeMs();
+uint64_t localEpochMs(uint64_t nowMs);
+void applyTimeSync(uint64_t epochMs, uint64_t nowMs);
+uint64_t timestampMs();
+void stampTime(JsonDocument &doc);
+void stampMessage(JsonDocument &doc);
+void loadBootCount();
+
+static const uint64_t EPOCH_MS = 1760000000000ULL; // Out/2025
+
+// Apaga a memória RTC, como numa queda de energia
+static void powerOn()
+{
+	uint32_t blank[128] = {};
+	ESP.rtcUserMemoryWrite(0, blank, sizeof(blank));
+}
+
+void setUp()
+{
+	timeSynced = false;
+	syncEpochMs = 0;
+	syncUptimeMs = 0;
+	driftPpm = 0;
+	lastTimestamp = 0;
+	messageSeq = 0;
+	delay(1000);
+}
+
+void tearDown() {}
+
+// ============================================================================
+// RELÓGIO
+// ============================================================================
+
+void test_unsynced_timestamp_is_uptime()
+{
+	TEST_ASSERT_EQUAL_UINT64(uptimeMs(), timestampMs());
+}
+
+void test_drift_applied_between_syncs()
+{
+	applyTimeSync(EPOCH_MS, uptimeMs());
+	driftPpm = 200;
+	delay(1000000);
+	TEST_ASSERT_EQUAL_UINT64(EPOCH_MS + 1000000 + 200, localEpochMs(uptimeMs()));
+
+	applyTimeSync(EPOCH_MS, uptimeMs());
+	driftPpm = -300;
+	delay(1000000);
+	TEST_ASSERT_EQUAL_UINT64(EPOCH_MS + 1000000 - 300, localEpochMs(uptimeMs()));
+}
+
+void test_sync_estimates_drift()
+{
+	applyTimeSync(EPOCH_MS, uptimeMs());
+	delay(600000);
+	applyTimeSync(EPOCH_MS + 600000 + 60, uptimeMs()); // 100 ppm adiantado
+
+	TEST_ASSERT_EQUAL_INT32(50, driftPpm); // Média com a estimativa anterior (0)
+	TEST_ASSERT_EQUAL_UINT64(EPOCH_MS + 600060, localEpochMs(uptimeMs()));
+}
+
+void test_clock_step_keeps_drift()
+{
+	driftPpm = 100;
+	applyTimeSync(EPOCH_MS, uptimeMs());
+	delay(60000);
+	applyTimeSync(EPOCH_MS + 60000 + 3600000, uptimeMs()); // Ajuste de 1 h
+	TEST_ASSERT_EQUAL_INT32(100, driftPpm);
+	TEST_ASSERT_EQUAL_UINT64(EPOCH_MS + 3660000, localEpochMs(uptimeMs()));
+
+	// Erro que estouraria int32 (primeiro sync com RTC zerado, por exemplo)
+	delay(60000);
+	applyTimeSync(EPOCH_MS * 2, uptimeMs());
+	TEST_ASSERT_EQUAL_INT32(100, driftPpm);
+
+	delay(60000);
+	applyTimeSync(EPOCH_MS, uptimeMs());
+	TEST_ASSERT_EQUAL_INT32(100, driftPpm);
+}
+
+void test_timestamp_monotonic_after_backwards_step()
+{
+	applyTimeSync(EPOCH_MS, uptimeMs());
+	delay(1000);
+	uint64_t before = timestampMs();
+	TEST_ASSERT_EQUAL_UINT64(EPOCH_MS + 1000, before);
+
+	applyTimeSync(EPOCH_MS + 1000 - 10000, uptimeMs()); // Relógio volta 10 s
+	TEST_ASSERT_EQUAL_UINT64(before, timestampMs());
+	delay(9999);
+	TEST_ASSERT_EQUAL_UINT64(before, timestampMs());
+	delay(2);
+	TEST_ASSERT_EQUAL_UINT64(before + 1, timestampMs());
+}
+
+// ============================================================================
+// CARIMBO DAS MENSAGENS
+// ============================================================================
+
+void test_stamp_message_seq_and_boot()
+{
+	JsonDocument first;
+	JsonDocument second;
+	JsonDocument state;
+	bootCount = 7;
+
+	stampMessage(first);
+	stampMessage(second);
+	stampTime(state);
+
+	TEST_ASSERT_EQUAL_UINT32(1, first["seq"].as<uint32_t>());
+	TEST_ASSERT_EQUAL_UINT32(2, second["seq"].as<uint32_t>());
+	TEST_ASSERT_EQUAL_UINT32(7, first["boot"].as<uint32_t>());
+	TEST_ASSERT_FALSE(first["synced"].as<bool>());
+	TEST_ASSERT_EQUAL_UINT64(uptimeMs(), first["ts"].as<uint64_t>());
+
+	// state/lwt: sem seq, o contador não avança
+	TEST_ASSERT_TRUE(state["seq"].isNull());
+	TEST_ASSERT_EQUAL_UINT32(7, state["boot"].as<uint32_t>());
+	TEST_ASSERT_EQUAL_UINT32(2, messageSeq);
+
+	applyTimeSync(EPOCH_MS, uptimeMs());
+	JsonDocument synced;
+	stampMessage(synced);
+	TEST_ASSERT_TRUE(synced["synced"].as<bool>());
+	TEST_ASSERT_EQUAL_UINT64(EPOCH_MS, synced["ts"].as<uint64_t>());
+	TEST_ASSERT_EQUAL_UINT32(3, synced["seq"].as<uint32_t>());
+}
+
+void test_boot_count_reserves_blocks()
+{
+	powerOn();
+	unsigned long commits = EEPROM.commits;
+	loadBootCount();
+	TEST_ASSERT_EQUAL_UINT32(1, bootCount);
+	TEST_ASSERT_EQUAL(commits + 1, EEPROM.commits);
+
+	// Resets a quente usam a reserva sem gravar na flash
+	for (uint32_t boot = 2; boot <= 16; boot++)
+	{
+		loadBootCount();
+		TEST_ASSERT_EQUAL_UINT32(boot, bootCount);
+	}
+	TEST_ASSERT_EQUAL(commits + 1, EEPROM.commits);
+
+	// Reserva esgotada: novo bloco
+	loadBootCount();
+	TEST_ASSERT_EQUAL_UINT32(17, bootCount);
+	TEST_ASSERT_EQUAL(commits + 2, EEPROM.commits);
+
+	// Queda de energia: pula o resto da reserva, sem repetir números
+	powerOn();
+	loadBootCount();
+	TEST_ASSERT_EQUAL_UINT32(33, bootCount);
+	TEST_ASSERT_EQUAL(commits + 3, EEPROM.commits);
+}
+
+int main(int argc, char **argv)
+{
+	(void)argc;
+	(void)argv;
+	UNITY_BEGIN();
+	RUN_TEST(test_unsynced_timestamp_is_uptime);
+	RUN_TEST(test_drift_applied_between_syncs);
+	RUN_TEST(test_sync_estimates_drift);
+	RUN_TEST(test_clock_step_keeps_drift);
+	RUN_TEST(test_timestamp_monotonic_after_backwards_step);
+	RUN_TEST(test_stamp_message_seq_and_boot);
+	RUN_TEST(test_boot_count_reserves_blocks);
+	return UNITY_END();
+}
@@ -0,0 +1,192 @@
+// ============================================================================
+// TESTES DO FORMATO DE TRACE (include/ldr_trace.h e native/ldr_trace_reader.h)
+// ============================================================================
+// pio test -e replay -f test_trace
+// ============================================================================
+
+#include <unity.h>
+#include <vector>
+#include "ldr_trace.h"
+#include "ldr_trace_reader.h"
+
+// ============================================================================
+// AUXILIARES
+// ============================================================================
+
+static void appendHeader(std::vector<uint8_t> &data, uint32_t baseMs)
+{
+	uint8_t header[TRACE_HEADER_SIZE];
+	traceEncodeHeader(header, baseMs);
+	data.insert(data.end(), header, header + sizeof(header));
+}
+
+// Grava uma amostra como o firmware (traceSample): saltos + registro
+static void appendSample(std::vector<uint8_t> &data, uint32_t dtMs, uint16_t value)
+{
+	uint8_t record[TRACE_RECORD_SIZE];
+	while (traceEncodeSkip(record, &dtMs))
+	{
+		data.insert(data.end(), record, record + sizeof(record));
+	}
+	traceEncodeRecord(record, (uint16_t)dtMs, value);
+	data.insert(data.end(), record, record + sizeof(record));
+}
+
+void setUp() {}
+void tearDown() {}
+
+// ============================================================================
+// CODIFICAÇÃO
+// ============================================================================
+
+void test_header_round_trip()
+{
+	uint8_t header[TRACE_HEADER_SIZE];
+	traceEncodeHeader(header, 0xDEADBEEF);
+
+	const uint8_t expected[TRACE_HEADER_SIZE] = {'L', 'D', 'R', 'T', TRACE_VERSION, 0, 0, 0, 0xEF, 0xBE, 0xAD, 0xDE};
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, header, sizeof(header));
+	TEST_ASSERT_EQUAL_UINT32(0xDEADBEEF, traceDecodeBase(header));
+}
+
+void test_record_round_trip()
+{
+	uint8_t record[TRACE_RECORD_SIZE];
+	uint16_t dtMs;
+	uint16_t value;
+
+	traceEncodeRecord(record, 0x1234, 1023);
+	const uint8_t expected[TRACE_RECORD_SIZE] = {0x34, 0x12, 0xFF, 0x03};
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, record, sizeof(record));
+
+	traceDecodeRecord(record, &dtMs, &value);
+	TEST_ASSERT_EQUAL_UINT16(0x1234, dtMs);
+	TEST_ASSERT_EQUAL_UINT16(1023, value);
+}
+
+void test_skip_splits_long_gap()
+{
+	uint8_t record[TRACE_RECORD_SIZE];
+	uint16_t dtMs;
+	uint16_t value;
+	uint32_t gap = 150000;
+	int skips = 0;
+
+	while (traceEncodeSkip(record, &gap))
+	{
+		traceDecodeRecord(record, &dtMs, &value);
+		TEST_ASSERT_EQUAL_UINT16(TRACE_MAX_DT_MS, dtMs);
+		TEST_ASSERT_EQUAL_UINT16(TRACE_SKIP_VALUE, value);
+		skips++;
+	}
+	TEST_ASSERT_EQUAL_INT(2, skips);
+	TEST_ASSERT_EQUAL_UINT32(150000 - 2 * TRACE_MAX_DT_MS, gap);
+
+	// Intervalo que cabe em um registro não gera salto
+	gap = TRACE_MAX_DT_MS;
+	TEST_ASSERT_FALSE(traceEncodeSkip(record, &gap));
+	TEST_ASSERT_EQUAL_UINT32(TRACE_MAX_DT_MS, gap);
+}
+
+// ============================================================================
+// LEITURA
+// ============================================================================
+
+void test_reader_restores_gap_times()
+{
+	std::vector<uint8_t> data;
+	std::vector<TraceSample> samples;
+	TraceReadStats stats;
+
+	appendHeader(data, 1000);
+	appendSample(data, 100, 500);
+	appendSample(data, 150000, 600);
+	appendSample(data, TRACE_MAX_DT_MS, 1024);
+
+	TEST_ASSERT_TRUE(traceRead(data, samples, stats));
+	TEST_ASSERT_EQUAL_size_t(3, samples.size());
+	TEST_ASSERT_EQUAL_UINT32(1100, samples[0].ms);
+	TEST_ASSERT_EQUAL_UINT16(500, samples[0].value);
+	TEST_ASSERT_EQUAL_UINT32(151100, samples[1].ms);
+	TEST_ASSERT_EQUAL_UINT16(600, samples[1].value);
+	TEST_ASSERT_EQUAL_UINT32(151100 + TRACE_MAX_DT_MS, samples[2].ms);
+	TEST_ASSERT_EQUAL_UINT16(1024, samples[2].value);
+	TEST_ASSERT_EQUAL_UINT32(1, stats.segments);
+	TEST_ASSERT_EQUAL_UINT32(0, stats.invalidRecords);
+	TEST_ASSERT_EQUAL_UINT32(0, stats.droppedBytes);
+}
+
+void test_reader_rejects_short_skip()
+{
+	std::vector<uint8_t> data;
+	std::vector<TraceSample> samples;
+	TraceReadStats stats;
+
+	appendHeader(data, 0);
+	appendSample(data, 100, 500);
+	appendSample(data, 100, TRACE_SKIP_VALUE); // Salto só existe com dt máximo
+
+	TEST_ASSERT_TRUE(traceRead(data, samples, stats));
+	TEST_ASSERT_EQUAL_size_t(1, samples.size());
+	TEST_ASSERT_EQUAL_UINT32(1, stats.invalidRecords);
+	TEST_ASSERT_EQUAL_UINT32(TRACE_RECORD_SIZE, stats.droppedBytes);
+}
+
+void test_reader_resyncs_after_lost_byte()
+{
+	std::vector<uint8_t> data;
+	std::vector<TraceSample> samples;
+	TraceReadStats stats;
+
+	data.push_back('x'); // Lixo do boot
+	appendHeader(data, 0);
+	appendSample(data, 100, 500);
+	appendSample(data, 100, 510);
+	appendSample(data, 100, 520);
+	data.erase(data.begin() + 1 + TRACE_HEADER_SIZE + TRACE_RECORD_SIZE); // Perde o 1º byte do 2º registro
+	appendHeader(data, 300);
+	appendSample(data, 100, 530);
+
+	TEST_ASSERT_TRUE(traceRead(data, samples, stats));
+	TEST_ASSERT_EQUAL_size_t(2, samples.size());
+	TEST_ASSERT_EQUAL_UINT32(100, samples[0].ms);
+	TEST_ASSERT_EQUAL_UINT32(400, samples[1].ms);
+	TEST_ASSERT_EQUAL_UINT16(530, samples[1].value);
+	TEST_ASSERT_EQUAL_UINT32(1, stats.segments);
+	TEST_ASSERT_EQUAL_UINT32(1, stats.invalidRecords);
+	TEST_ASSERT_EQUAL_UINT32(2 * TRACE_RECORD_SIZE - 1, stats.droppedBytes);
+	TEST_ASSERT_EQUAL_UINT32(1, stats.prefixBytes);
+}
+
+void test_reader_starts_segment_on_reset()
+{
+	std::vector<uint8_t> data;
+	std::vector<TraceSample> samples;
+	TraceReadStats stats;
+
+	appendHeader(data, 5000);
+	appendSample(data, 100, 500);
+	appendHeader(data, 200); // millis() voltou: reset
+	appendSample(data, 100, 510);
+
+	TEST_ASSERT_TRUE(traceRead(data, samples, stats));
+	TEST_ASSERT_EQUAL_UINT32(2, stats.segments);
+	TEST_ASSERT_EQUAL_size_t(2, samples.size());
+	TEST_ASSERT_EQUAL_UINT32(5100, samples[0].ms);
+	TEST_ASSERT_EQUAL_UINT32(5200, samples[1].ms); // Continua após o segmento anterior
+}
+
+int main(int argc, char **argv)
+{
+	(void)argc;
+	(void)argv;
+	UNITY_BEGIN();
+	RUN_TEST(test_header_round_trip);
+	RUN_TEST(test_record_round_trip);
+	RUN_TEST(test_skip_splits_long_gap);
+	RUN_TEST(test_reader_restores_gap_times);
+	RUN_TEST(test_reader_rejects_short_skip);
+	RUN_TEST(test_reader_resyncs_after_lost_byte);
+	RUN_TEST(test_reader_starts_segment_on_reset);
+	return UNITY_END();
+}